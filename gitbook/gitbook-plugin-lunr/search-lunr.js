@@ -7,46 +7,135 @@ require([
         this.index = null;
         this.store = {};
         this.name = 'LunrSearchEngine';
+        this.loading = null;
     }
 
-    // Initialize lunr by fetching the search index
+    // Rebuild a lunr index from the packed form written by
+    // scripts/pack-search-index.js
+    function loadPackedIndex(data) {
+        // eslint-disable-next-line no-undef
+        var tokenStore = new lunr.TokenStore();
+        var documentStore = {};
+        var store = {};
+        var tokens = Object.keys(data.tokens).sort();
+
+        $.each(data.docs, function(i, doc) {
+            documentStore[doc[0]] = [];
+            store[doc[0]] = { url: doc[0], title: doc[1], body: doc[2] };
+        });
+
+        // Tokens are added in sorted order, so every document's token
+        // list comes out sorted as lunr.SortedSet expects
+        $.each(tokens, function(i, token) {
+            var postings = data.tokens[token];
+
+            for (var j = 0; j < postings.length; j += 2) {
+                var ref = data.docs[postings[j]][0];
+
+                tokenStore.add(token, { ref: ref, tf: postings[j + 1] });
+                documentStore[ref].push(token);
+            }
+        });
+
+        return {
+            // eslint-disable-next-line no-undef
+            index: lunr.Index.load({
+                version: data.version,
+                fields: data.fields,
+                ref: data.ref,
+                documentStore: { store: documentStore, length: data.docs.length },
+                tokenStore: tokenStore.toJSON(),
+                corpusTokens: tokens,
+                pipeline: data.pipeline
+            }),
+            store: store
+        };
+    }
+
+    // Nothing is fetched until the first query
     LunrSearchEngine.prototype.init = function() {
+        return $.Deferred().resolve().promise();
+    };
+
+    // Fetch the packed index, falling back to the full search_index.json
+    // when it is missing, unreadable or packed from another build
+    LunrSearchEngine.prototype.load = function() {
         var that = this;
+
+        if (this.loading) return this.loading;
+
         var d = $.Deferred();
+        this.loading = d.promise();
 
-        $.getJSON(gitbook.state.basePath+'/search_index.json')
-        .then(function(data) {
-            // eslint-disable-next-line no-undef
-            that.index = lunr.Index.load(data.index);
-            that.store = data.store;
+        function loadFullIndex() {
+            $.getJSON(gitbook.state.basePath+'/search_index.json')
+            .done(function(data) {
+                // eslint-disable-next-line no-undef
+                that.index = lunr.Index.load(data.index);
+                that.store = data.store;
+                d.resolve();
+            })
+            .fail(function() {
+                // Allow the next query to retry
+                that.loading = null;
+                d.reject();
+            });
+        }
+
+        $.getJSON(gitbook.state.basePath+'/search_index.min.json')
+        .done(function(data) {
+            var loaded;
+
+            if (data.revision !== gitbook.state.revision) {
+                loadFullIndex();
+                return;
+            }
+
+            try {
+                loaded = loadPackedIndex(data);
+            } catch (e) {
+                loadFullIndex();
+                return;
+            }
+
+            that.index = loaded.index;
+            that.store = loaded.store;
             d.resolve();
-        });
+        })
+        .fail(loadFullIndex);
 
-        return d.promise();
+        return this.loading;
     };
 
     // Search for a term and return results
     LunrSearchEngine.prototype.search = function(q, offset, length) {
         var that = this;
-        var results = [];
+        var d = $.Deferred();
+
+        this.load()
+        .always(function() {
+            var results = [];
+
+            if (that.index) {
+                results = $.map(that.index.search(q), function(result) {
+                    var doc = that.store[result.ref];
 
-        if (this.index) {
-            results = $.map(this.index.search(q), function(result) {
-                var doc = that.store[result.ref];
+                    return {
+                        title: doc.title,
+                        url: doc.url,
+                        body: doc.summary || doc.body
+                    };
+                });
+            }
 
-                return {
-                    title: doc.title,
-                    url: doc.url,
-                    body: doc.summary || doc.body
-                };
+            d.resolve({
+                query: q,
+                results: results.slice(0, length),
+                count: results.length
             });
-        }
+        });
 
-        return $.Deferred().resolve({
-            query: q,
-            results: results.slice(0, length),
-            count: results.length
-        }).promise();
+        return d.promise();
     };
 
     // Set gitbook research
@@ -0,0 +1,102 @@
+#!/usr/bin/env node
+/*
+ * Pack search_index.json, as written by gitbook-plugin-lunr, into the
+ * compact search_index.min.json loaded by search-lunr.js.
+ *
+ * The lunr 0.5 index serializes its token trie node by node and repeats
+ * every document's token list in the document store, so most of the file
+ * is structure rather than data.  The packed form keeps one posting list
+ * per token and numbers documents, which is all search-lunr.js needs to
+ * rebuild those structures without re-indexing any text.  Result bodies
+ * are cut to what the search results list displays.
+ *
+ * The packed file records the build time GitBook stamps into index.html.
+ * search-lunr.js compares it with the revision of the page being viewed
+ * and loads search_index.json instead when they differ, so a book rebuilt
+ * without repacking still searches current content, only more slowly.
+ * `gitbook build` also copies the stock search-lunr.js over ours, which
+ * always loads search_index.json; re-apply it along with repacking.
+ *
+ * Run from the book root after every `gitbook build`:
+ *
+ *     node scripts/pack-search-index.js [search_index.json] [search_index.min.json]
+ */
+
+var fs   = require('fs');
+var path = require('path');
+
+// Keep in sync with MAX_DESCRIPTION_SIZE in gitbook-plugin-search/search.js
+var MAX_DESCRIPTION_SIZE = 500;
+
+// Significant digits kept for term frequencies
+var TF_PRECISION = 6;
+
+var input  = process.argv[2] || 'search_index.json';
+var output = process.argv[3] || 'search_index.min.json';
+
+// Build time of the book the index belongs to, as in gitbook.state.revision
+var html     = fs.readFileSync(path.join(path.dirname(input), 'index.html'), 'utf8');
+var revision = /"gitbook":\{"version":"[^"]*","time":"([^"]*)"\}/.exec(html);
+if (!revision) {
+    console.error('no GitBook build time found in index.html');
+    process.exit(1);
+}
+
+var data  = JSON.parse(fs.readFileSync(input, 'utf8'));
+var index = data.index;
+
+// Number documents in document store order
+var refs  = Object.keys(index.documentStore.store);
+var docId = {};
+var docs  = refs.map(function(ref, i) {
+    var doc  = data.store[ref] || {};
+    var body = (doc.summary || doc.body || '').trim();
+
+    docId[ref] = i;
+
+    // search.js trims the body and appends an ellipsis only when it is
+    // still longer than MAX_DESCRIPTION_SIZE, so end a cut body with a
+    // non-whitespace marker that trimming cannot drop
+    if (body.length > MAX_DESCRIPTION_SIZE) {
+        body = body.slice(0, MAX_DESCRIPTION_SIZE) + '.';
+    }
+
+    return [ref, doc.title || '', body];
+});
+
+// Flatten the token trie into token -> [doc, tf, doc, tf, ...]
+var tokens = {};
+function walk(node, prefix) {
+    Object.keys(node).forEach(function(key) {
+        if (key === 'docs') return;
+
+        var child    = node[key];
+        var token    = prefix + key;
+        var postings = Object.keys(child.docs);
+
+        if (postings.length > 0) {
+            tokens[token] = [];
+            postings.forEach(function(ref) {
+                tokens[token].push(docId[ref],
+                    Number(child.docs[ref].tf.toPrecision(TF_PRECISION)));
+            });
+        }
+        walk(child, token);
+    });
+}
+walk(index.tokenStore.root, '');
+
+var packed = {
+    revision: revision[1],
+    version:  index.version,
+    fields:   index.fields,
+    ref:      index.ref,
+    pipeline: index.pipeline,
+    docs:     docs,
+    tokens:   tokens
+};
+
+fs.writeFileSync(output, JSON.stringify(packed));
+
+console.log(input + ': ' + fs.statSync(input).size + ' bytes -> ' +
+    output + ': ' + fs.statSync(output).size + ' bytes');